@@ -45,7 +45,19 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define DEBUG_VAR(fmt,var,args...)
 #endif
 
-#define ANIM_TIME   500
+#define NOTIFY_NAME "org.freedesktop.Notifications"
+#define NOTIFY_PATH "/org/freedesktop/Notifications"
+
+#define MSECS(t)    ((int) ((g_get_monotonic_time () - (t)) / 1000))
+
+#define PROFILE_TIMEOUT 30000
+
+typedef struct
+{
+    ConnectPlugin *c;
+    const char *method;
+    gint64 start;
+} ProfileCall;
 
 /*----------------------------------------------------------------------------*/
 /* Global data                                                                */
@@ -72,12 +84,28 @@ static void handle_toggle_ssh (GtkWidget *, ConnectPlugin *);
 static void cb_result (GObject *, GAsyncResult *, ConnectPlugin *);
 static void handle_status_req (GtkWidget *, ConnectPlugin *c);
 static void cb_status_req (GObject *, GAsyncResult *, ConnectPlugin *);
+static void notify_sessions (ConnectPlugin *c, int old_vnc, int old_ssh);
+static void send_notification (ConnectPlugin *c, GDBusConnection *conn);
+static void close_notification (ConnectPlugin *c, GDBusConnection *conn);
+static void cb_notify (GObject *, GAsyncResult *, ConnectPlugin *);
+static gboolean handle_profile (ConnectPlugin *c, const char *args);
+static gboolean parse_setting (const char *token, const char *key, int *val);
+static void apply_profile (ConnectPlugin *c);
+static void cancel_profile (ConnectPlugin *c, const char *reason);
+static void profile_call (ConnectPlugin *c, const char *method);
+static void cb_profile (GObject *, GAsyncResult *, ProfileCall *);
 static void toggle_enabled (GtkWidget *, ConnectPlugin *);
 static void show_help (GtkWidget *, ConnectPlugin *);
 static void show_menu (ConnectPlugin *);
+static const char *session_text (ConnectPlugin *c);
 static void update_icon (ConnectPlugin *);
 static gboolean animate (ConnectPlugin *c);
-static void cache_animation (ConnectPlugin *c, gboolean clear);
+static void cache_animation (ConnectPlugin *c);
+static void clear_animation (ConnectPlugin *c);
+static GdkPixbuf *render_frame (const char *svg, double angle, int width, int height);
+static void set_timer (ConnectPlugin *c);
+static void startup_phase (ConnectPlugin *c, const char *phase);
+static void check_started (ConnectPlugin *c);
 static void connect_button_press_event (GtkButton *, ConnectPlugin *);
 
 /*----------------------------------------------------------------------------*/
@@ -102,14 +130,22 @@ static void cb_name_owned (GDBusConnection *conn, const gchar *name, const gchar
     check_installed (c);
 
     // create the proxy
-    g_dbus_proxy_new (conn, G_DBUS_PROXY_FLAGS_NONE, NULL, name, "/com/raspberrypi/Connect", "com.raspberrypi.Connect", NULL, (GAsyncReadyCallback) cb_proxy_result, c);
+    g_dbus_proxy_new (conn, G_DBUS_PROXY_FLAGS_NONE, NULL, name, "/com/raspberrypi/Connect", "com.raspberrypi.Connect", c->cancellable, (GAsyncReadyCallback) cb_proxy_result, c);
 }
 
 static void cb_proxy_result (GObject *, GAsyncResult *res, ConnectPlugin *c)
 {
     GError *error = NULL;
-    c->proxy = g_dbus_proxy_new_finish (res, &error);
+    GDBusProxy *proxy = g_dbus_proxy_new_finish (res, &error);
 
+    // plugin has been destroyed
+    if (g_error_matches (error, G_IO_ERROR, G_IO_ERROR_CANCELLED))
+    {
+        g_error_free (error);
+        return;
+    }
+
+    c->proxy = proxy;
     if (error)
     {
         DEBUG ("Getting proxy - error %s", error->message);
@@ -125,21 +161,34 @@ static void cb_proxy_result (GObject *, GAsyncResult *res, ConnectPlugin *c)
     }
 }
 
-static void cb_name_unowned (GDBusConnection *, const gchar *name, ConnectPlugin *c)
+static void cb_name_unowned (GDBusConnection *conn, const gchar *name, ConnectPlugin *c)
 {
     DEBUG ("Name %s unowned on DBus", name);
 
     if (c->proxy) g_object_unref (c->proxy);
     c->proxy = NULL;
     c->enabled = FALSE;
+
+    // no sessions without the service - withdraw any notification and wait for a new baseline
+    c->vnc_sess_count = 0;
+    c->ssh_sess_count = 0;
+    c->have_status = FALSE;
+    if (c->notify_busy) c->notify_dirty = TRUE;
+    else if (conn) close_notification (c, conn);
+    cancel_profile (c, "Connect is not running");
+
     check_installed (c);
     update_icon (c);
+    c->state_known = TRUE;
+    check_started (c);
 }
 
 /* Proxy callbacks */
 
 static void cb_status (GDBusProxy *, char *, char *signal, GVariant *params, ConnectPlugin *c)
 {
+    int old_vnc = c->vnc_sess_count, old_ssh = c->ssh_sess_count;
+
     if (strcmp (signal, "Status"))
     {
         DEBUG ("Unexpected signal");
@@ -148,7 +197,10 @@ static void cb_status (GDBusProxy *, char *, char *signal, GVariant *params, Con
     {
         DEBUG ("Status message received - %s", g_variant_print (params, TRUE));
         g_variant_get (params, "((bbbbii))", &c->signed_in, &c->vnc_avail, &c->vnc_on, &c->ssh_on, &c->vnc_sess_count, &c->ssh_sess_count);
-        update_icon (c);
+
+        // a profile reconciles and redraws once all of its calls have completed
+        if (!c->prof_calls) update_icon (c);
+        if (c->have_status) notify_sessions (c, old_vnc, old_ssh);
     }
 }
 
@@ -157,13 +209,13 @@ static void cb_status (GDBusProxy *, char *, char *signal, GVariant *params, Con
 static void handle_sign_in (GtkWidget *, ConnectPlugin *c)
 {
     DEBUG ("Calling SignIn");
-    g_dbus_proxy_call (c->proxy, "com.raspberrypi.Connect.SignIn", NULL, G_DBUS_CALL_FLAGS_NONE, -1, NULL, (GAsyncReadyCallback) cb_result, c);
+    g_dbus_proxy_call (c->proxy, "com.raspberrypi.Connect.SignIn", NULL, G_DBUS_CALL_FLAGS_NONE, -1, c->cancellable, (GAsyncReadyCallback) cb_result, c);
 }
 
 static void handle_sign_out (GtkWidget *, ConnectPlugin *c)
 {
     DEBUG ("Calling SignOut");
-    g_dbus_proxy_call (c->proxy, "com.raspberrypi.Connect.SignOut", NULL, G_DBUS_CALL_FLAGS_NONE, -1, NULL, (GAsyncReadyCallback) cb_result, c);
+    g_dbus_proxy_call (c->proxy, "com.raspberrypi.Connect.SignOut", NULL, G_DBUS_CALL_FLAGS_NONE, -1, c->cancellable, (GAsyncReadyCallback) cb_result, c);
 }
 
 static void handle_toggle_vnc (GtkWidget *, ConnectPlugin *c)
@@ -171,12 +223,12 @@ static void handle_toggle_vnc (GtkWidget *, ConnectPlugin *c)
     if (c->vnc_on)
     {
         DEBUG ("Calling VncOff");
-        g_dbus_proxy_call (c->proxy, "com.raspberrypi.Connect.VncOff", NULL, G_DBUS_CALL_FLAGS_NONE, -1, NULL, (GAsyncReadyCallback) cb_result, c);
+        g_dbus_proxy_call (c->proxy, "com.raspberrypi.Connect.VncOff", NULL, G_DBUS_CALL_FLAGS_NONE, -1, c->cancellable, (GAsyncReadyCallback) cb_result, c);
     }
     else
     {
         DEBUG ("Calling VncOn");
-        g_dbus_proxy_call (c->proxy, "com.raspberrypi.Connect.VncOn", NULL, G_DBUS_CALL_FLAGS_NONE, -1, NULL, (GAsyncReadyCallback) cb_result, c);
+        g_dbus_proxy_call (c->proxy, "com.raspberrypi.Connect.VncOn", NULL, G_DBUS_CALL_FLAGS_NONE, -1, c->cancellable, (GAsyncReadyCallback) cb_result, c);
     }
 }
 
@@ -185,12 +237,12 @@ static void handle_toggle_ssh (GtkWidget *, ConnectPlugin *c)
     if (c->ssh_on)
     {
         DEBUG ("Calling ShellOff");
-        g_dbus_proxy_call (c->proxy, "com.raspberrypi.Connect.ShellOff", NULL, G_DBUS_CALL_FLAGS_NONE, -1, NULL, (GAsyncReadyCallback) cb_result, c);
+        g_dbus_proxy_call (c->proxy, "com.raspberrypi.Connect.ShellOff", NULL, G_DBUS_CALL_FLAGS_NONE, -1, c->cancellable, (GAsyncReadyCallback) cb_result, c);
     }
     else
     {
         DEBUG ("Calling ShellOn");
-        g_dbus_proxy_call (c->proxy, "com.raspberrypi.Connect.ShellOn", NULL, G_DBUS_CALL_FLAGS_NONE, -1, NULL, (GAsyncReadyCallback) cb_result, c);
+        g_dbus_proxy_call (c->proxy, "com.raspberrypi.Connect.ShellOn", NULL, G_DBUS_CALL_FLAGS_NONE, -1, c->cancellable, (GAsyncReadyCallback) cb_result, c);
     }
 }
 
@@ -214,14 +266,24 @@ static void cb_result (GObject *source, GAsyncResult *res, ConnectPlugin *)
 static void handle_status_req (GtkWidget *, ConnectPlugin *c)
 {
     DEBUG ("Calling Status");
-    g_dbus_proxy_call (c->proxy, "com.raspberrypi.Connect.Status", NULL, G_DBUS_CALL_FLAGS_NONE, -1, NULL, (GAsyncReadyCallback) cb_status_req, c);
+    g_dbus_proxy_call (c->proxy, "com.raspberrypi.Connect.Status", NULL, G_DBUS_CALL_FLAGS_NONE, -1, c->cancellable, (GAsyncReadyCallback) cb_status_req, c);
 }
 
 static void cb_status_req (GObject *source, GAsyncResult *res, ConnectPlugin *c)
 {
     GError *error = NULL;
     GVariant *var = g_dbus_proxy_call_finish (G_DBUS_PROXY (source), res, &error);
-    
+    int old_vnc, old_ssh;
+
+    // plugin has been destroyed
+    if (g_error_matches (error, G_IO_ERROR, G_IO_ERROR_CANCELLED))
+    {
+        g_error_free (error);
+        return;
+    }
+    old_vnc = c->vnc_sess_count;
+    old_ssh = c->ssh_sess_count;
+
     // update the enabled flag here in case it has changed externally
     if (!system ("systemctl --user -q is-active rpi-connect.service")) c->enabled = TRUE;
     else c->enabled = FALSE;
@@ -230,12 +292,19 @@ static void cb_status_req (GObject *source, GAsyncResult *res, ConnectPlugin *c)
     {
         DEBUG ("Status - error %s", error->message);
         g_error_free (error);
+        cancel_profile (c, "no status from Connect");
     }
     else
     {
         DEBUG_VAR ("Status - result %s", var);
         g_variant_get (var, "((bbbbii))", &c->signed_in, &c->vnc_avail, &c->vnc_on, &c->ssh_on, &c->vnc_sess_count, &c->ssh_sess_count);
         update_icon (c);
+
+        // the first reply is a baseline - sessions already running when the panel started are not new
+        if (c->have_status) notify_sessions (c, old_vnc, old_ssh);
+        c->have_status = TRUE;
+        c->state_known = TRUE;
+        check_started (c);
     }
     if (var) g_variant_unref (var);
 
@@ -244,6 +313,239 @@ static void cb_status_req (GObject *source, GAsyncResult *res, ConnectPlugin *c)
     {
         if (c->enabled && !c->signed_in) handle_sign_in (NULL, c);
         c->enabling = FALSE;
+
+        // apply any settings from a profile which turned Connect on
+        if (c->prof_vnc != -1 || c->prof_ssh != -1) apply_profile (c);
+    }
+}
+
+/* Profiles - set several options in one control message */
+
+static gboolean handle_profile (ConnectPlugin *c, const char *args)
+{
+    gchar **tokens;
+    int count, enable = -1, vnc = -1, ssh = -1;
+    gboolean res = TRUE;
+
+    // settings waiting for the service to start count as in progress, unless it never arrived
+    if (!c->prof_calls && (c->prof_vnc != -1 || c->prof_ssh != -1) && MSECS (c->prof_time) > PROFILE_TIMEOUT)
+        cancel_profile (c, "service did not start");
+    if (c->prof_calls || c->prof_vnc != -1 || c->prof_ssh != -1)
+    {
+        g_message ("connect: profile - previous profile still in progress");
+        return FALSE;
+    }
+
+    tokens = g_strsplit_set (args, " \t\n", -1);
+    for (count = 0; tokens[count]; count++)
+    {
+        if (!*tokens[count]) continue;
+        if (parse_setting (tokens[count], "enabled", &enable)) continue;
+        if (parse_setting (tokens[count], "vnc", &vnc)) continue;
+        if (parse_setting (tokens[count], "ssh", &ssh)) continue;
+
+        g_message ("connect: profile - invalid setting %s", tokens[count]);
+        res = FALSE;
+        break;
+    }
+    g_strfreev (tokens);
+    if (!res) return FALSE;
+
+    c->prof_time = g_get_monotonic_time ();
+
+    if (enable != -1 && enable != c->enabled)
+    {
+        toggle_enabled (NULL, c);
+        g_message ("connect: profile - %s (%d ms)", enable ? "turned on" : "turned off", MSECS (c->prof_time));
+
+        // remaining settings are applied once the service has reported its status
+        if (enable)
+        {
+            c->prof_vnc = vnc;
+            c->prof_ssh = ssh;
+        }
+        else
+        {
+            if (vnc != -1) g_message ("connect: profile - Connect turned off, vnc setting skipped");
+            if (ssh != -1) g_message ("connect: profile - Connect turned off, ssh setting skipped");
+        }
+        return TRUE;
+    }
+
+    c->prof_vnc = vnc;
+    c->prof_ssh = ssh;
+    apply_profile (c);
+    return TRUE;
+}
+
+static gboolean parse_setting (const char *token, const char *key, int *val)
+{
+    int len = strlen (key);
+
+    if (strncmp (token, key, len) || token[len] != '=') return FALSE;
+    token += len + 1;
+
+    if (!strcmp (token, "on")) *val = TRUE;
+    else if (!strcmp (token, "off")) *val = FALSE;
+    else return FALSE;
+    return TRUE;
+}
+
+static void apply_profile (ConnectPlugin *c)
+{
+    if (!c->proxy || !c->enabled)
+    {
+        cancel_profile (c, "Connect is not running");
+        return;
+    }
+    if (!c->signed_in)
+    {
+        cancel_profile (c, "not signed in");
+        return;
+    }
+
+    // issue all of the calls needed to reach the requested state at once
+    if (c->prof_vnc != -1 && c->prof_vnc != c->vnc_on)
+    {
+        if (c->vnc_avail) profile_call (c, c->prof_vnc ? "VncOn" : "VncOff");
+        else g_message ("connect: profile - screen sharing not available, vnc setting skipped");
+    }
+    if (c->prof_ssh != -1 && c->prof_ssh != c->ssh_on)
+        profile_call (c, c->prof_ssh ? "ShellOn" : "ShellOff");
+
+    c->prof_vnc = c->prof_ssh = -1;
+    if (!c->prof_calls) g_message ("connect: profile - no changes needed (%d ms)", MSECS (c->prof_time));
+}
+
+static void cancel_profile (ConnectPlugin *c, const char *reason)
+{
+    if (c->prof_vnc == -1 && c->prof_ssh == -1) return;
+
+    g_message ("connect: profile - %s, settings not applied (%d ms)", reason, MSECS (c->prof_time));
+    c->prof_vnc = c->prof_ssh = -1;
+}
+
+static void profile_call (ConnectPlugin *c, const char *method)
+{
+    ProfileCall *call = g_new0 (ProfileCall, 1);
+    char *name = g_strdup_printf ("com.raspberrypi.Connect.%s", method);
+
+    call->c = c;
+    call->method = method;
+    call->start = g_get_monotonic_time ();
+    c->prof_calls++;
+
+    DEBUG ("Calling %s", method);
+    g_dbus_proxy_call (c->proxy, name, NULL, G_DBUS_CALL_FLAGS_NONE, -1, c->cancellable, (GAsyncReadyCallback) cb_profile, call);
+    g_free (name);
+}
+
+static void cb_profile (GObject *source, GAsyncResult *res, ProfileCall *call)
+{
+    ConnectPlugin *c = call->c;
+    GError *error = NULL;
+    GVariant *var = g_dbus_proxy_call_finish (G_DBUS_PROXY (source), res, &error);
+
+    // plugin has been destroyed
+    if (g_error_matches (error, G_IO_ERROR, G_IO_ERROR_CANCELLED))
+    {
+        g_error_free (error);
+        g_free (call);
+        return;
+    }
+
+    if (error)
+    {
+        g_message ("connect: profile - %s failed - %s (%d ms)", call->method, error->message, MSECS (call->start));
+        g_error_free (error);
+    }
+    else g_message ("connect: profile - %s succeeded (%d ms)", call->method, MSECS (call->start));
+    if (var) g_variant_unref (var);
+    g_free (call);
+
+    // once everything has completed, reconcile with the service and redraw once
+    if (--c->prof_calls == 0)
+    {
+        g_message ("connect: profile - complete (%d ms)", MSECS (c->prof_time));
+        if (c->proxy) handle_status_req (NULL, c);
+        else update_icon (c);
+    }
+}
+
+/* Desktop notifications */
+
+static void notify_sessions (ConnectPlugin *c, int old_vnc, int old_ssh)
+{
+    GDBusConnection *conn;
+
+    if (old_vnc == c->vnc_sess_count && old_ssh == c->ssh_sess_count) return;
+    if (!c->proxy) return;
+    conn = g_dbus_proxy_get_connection (c->proxy);
+
+    // only alert on the first session; later changes just update the existing notification
+    if (c->vnc_sess_count + c->ssh_sess_count == 0 || old_vnc + old_ssh == 0 || c->notify_id || c->notify_busy)
+    {
+        c->notify_time = g_get_monotonic_time ();
+        if (c->notify_busy) c->notify_dirty = TRUE;
+        else if (c->vnc_sess_count + c->ssh_sess_count > 0) send_notification (c, conn);
+        else close_notification (c, conn);
+    }
+}
+
+static void close_notification (ConnectPlugin *c, GDBusConnection *conn)
+{
+    // all sessions have ended - withdraw the notification
+    if (c->notify_id)
+    {
+        DEBUG ("Calling CloseNotification %u", c->notify_id);
+        g_dbus_connection_call (conn, NOTIFY_NAME, NOTIFY_PATH, NOTIFY_NAME, "CloseNotification",
+            g_variant_new ("(u)", c->notify_id), NULL, G_DBUS_CALL_FLAGS_NONE, -1, NULL, NULL, NULL);
+    }
+    c->notify_id = 0;
+}
+
+static void send_notification (ConnectPlugin *c, GDBusConnection *conn)
+{
+    DEBUG ("Calling Notify - replaces %u", c->notify_id);
+    c->notify_busy = TRUE;
+    c->notify_dirty = FALSE;
+    g_dbus_connection_call (conn, NOTIFY_NAME, NOTIFY_PATH, NOTIFY_NAME, "Notify",
+        g_variant_new ("(susssasa{sv}i)", "wf-panel-pi", c->notify_id, "rpc-active", _("Raspberry Pi Connect"),
+            session_text (c), NULL, NULL, -1),
+        G_VARIANT_TYPE ("(u)"), G_DBUS_CALL_FLAGS_NONE, -1, c->cancellable, (GAsyncReadyCallback) cb_notify, c);
+}
+
+static void cb_notify (GObject *source, GAsyncResult *res, ConnectPlugin *c)
+{
+    GError *error = NULL;
+    GVariant *var = g_dbus_connection_call_finish (G_DBUS_CONNECTION (source), res, &error);
+
+    // plugin has been destroyed
+    if (g_error_matches (error, G_IO_ERROR, G_IO_ERROR_CANCELLED))
+    {
+        g_error_free (error);
+        return;
+    }
+
+    c->notify_busy = FALSE;
+    if (error)
+    {
+        DEBUG ("Notify - error %s", error->message);
+        g_error_free (error);
+    }
+    else
+    {
+        g_variant_get (var, "(u)", &c->notify_id);
+        DEBUG ("Notify - id %u, %" G_GINT64_FORMAT " us after status", c->notify_id, g_get_monotonic_time () - c->notify_time);
+    }
+    if (var) g_variant_unref (var);
+
+    // sessions changed while the call was in flight - coalesce into this notification
+    if (c->notify_dirty)
+    {
+        c->notify_dirty = FALSE;
+        if (c->proxy && c->vnc_sess_count + c->ssh_sess_count > 0) send_notification (c, G_DBUS_CONNECTION (source));
+        else close_notification (c, G_DBUS_CONNECTION (source));
     }
 }
 
@@ -254,6 +556,9 @@ static void cb_status_req (GObject *source, GAsyncResult *res, ConnectPlugin *c)
 
 static void toggle_enabled (GtkWidget *, ConnectPlugin *c)
 {
+    // an explicit change supersedes any profile settings still waiting
+    cancel_profile (c, "superseded");
+
     if (c->enabled)
     {
         system ("rpi-connect off");
@@ -342,6 +647,16 @@ static void show_menu (ConnectPlugin *c)
     gtk_widget_show_all (c->menu);
 }
 
+static const char *session_text (ConnectPlugin *c)
+{
+    if (c->vnc_sess_count == 0)
+        return _("Your device is being accessed via remote shell - Raspberry Pi Connect");
+    else if (c->ssh_sess_count == 0)
+        return _("Your screen is being shared - Raspberry Pi Connect");
+    else
+        return _("Your device is being accessed - Raspberry Pi Connect");
+}
+
 static void update_icon (ConnectPlugin *c)
 {
     // hide icon if not installed ?
@@ -366,14 +681,9 @@ static void update_icon (ConnectPlugin *c)
         {
             if (c->vnc_sess_count + c->ssh_sess_count > 0)
             {
-                if (c->vnc_sess_count == 0)
-                    gtk_widget_set_tooltip_text (c->tray_icon, _("Your device is being accessed via remote shell - Raspberry Pi Connect"));
-                else if (c->ssh_sess_count == 0)
-                    gtk_widget_set_tooltip_text (c->tray_icon, _("Your screen is being shared - Raspberry Pi Connect"));
-                else
-                    gtk_widget_set_tooltip_text (c->tray_icon, _("Your device is being accessed - Raspberry Pi Connect"));
+                gtk_widget_set_tooltip_text (c->tray_icon, session_text (c));
 
-                if (c->animate)
+                if (c->animate && c->anim_count)
                 {
                     c->anim_frame = 0;
                     set_image_from_pixbuf (c->tray_icon, c->anim[c->anim_frame]);
@@ -399,10 +709,10 @@ static gboolean animate (ConnectPlugin *c)
 {
     if (c->enabled && c->signed_in && c->vnc_sess_count + c->ssh_sess_count > 0)
     {
-        if (c->animate)
+        if (c->animate && c->anim_count)
         {
             c->anim_frame++;
-            if (c->anim_frame > (ANIM_FRAMES - 1)) c->anim_frame = 0;
+            if (c->anim_frame > (c->anim_count - 1)) c->anim_frame = 0;
             set_image_from_pixbuf (c->tray_icon, c->anim[c->anim_frame]);
         }
         else
@@ -417,18 +727,136 @@ static gboolean animate (ConnectPlugin *c)
     return TRUE;
 }
 
-static void cache_animation (ConnectPlugin *c, gboolean clear)
+static void cache_animation (ConnectPlugin *c)
+{
+    GtkIconInfo *info;
+    GdkPixbuf *base;
+    gchar *svg;
+    gint64 start = g_get_monotonic_time ();
+    int count, width, height;
+
+    // frames are only regenerated if the panel's icon size or the frame count has changed
+    if (c->anim_count && c->anim_req == c->anim_frames && c->anim_size == c->icon_size) return;
+
+    // the first frame is the unrotated icon, which also gives the pixel size the panel wants
+    clear_animation (c);
+    base = wrap_load_taskbar_pixbuf (c, c->tray_icon, "rpc-anim");
+    if (!base) return;
+    width = gdk_pixbuf_get_width (base);
+    height = gdk_pixbuf_get_height (base);
+
+    c->anim = g_new0 (GdkPixbuf *, c->anim_frames);
+    c->anim[0] = base;
+    c->anim_count = 1;
+    c->anim_size = c->icon_size;
+    c->anim_req = c->anim_frames;
+
+    // remaining frames are rendered from the SVG source, each rotated a further step
+    info = gtk_icon_theme_lookup_icon (gtk_icon_theme_get_default (), "rpc-anim", width, GTK_ICON_LOOKUP_FORCE_SVG);
+    if (info && gtk_icon_info_get_filename (info) && g_file_get_contents (gtk_icon_info_get_filename (info), &svg, NULL, NULL))
+    {
+        for (count = 1; count < c->anim_frames; count++)
+        {
+            c->anim[count] = render_frame (svg, count * 180.0 / c->anim_frames, width, height);
+            if (!c->anim[count]) break;
+            c->anim_count++;
+        }
+        g_free (svg);
+    }
+    if (info) g_object_unref (info);
+
+    // the steps assume a full cycle - if one can't be generated, show the first frame alone
+    if (c->anim_count < c->anim_frames)
+    {
+        for (count = 1; count < c->anim_count; count++) g_object_unref (c->anim[count]);
+        c->anim_count = 1;
+    }
+
+    DEBUG ("Animation - %d frames at %dx%d in %d ms", c->anim_count, width, height, MSECS (start));
+}
+
+static void clear_animation (ConnectPlugin *c)
 {
-    char *iname;
     int count;
 
-    for (count = 0; count < ANIM_FRAMES; count++)
+    for (count = 0; count < c->anim_count; count++)
+        if (c->anim[count]) g_object_unref (c->anim[count]);
+    g_free (c->anim);
+    c->anim = NULL;
+    c->anim_count = 0;
+    c->anim_size = 0;
+    c->anim_req = 0;
+    if (c->anim_frame > 0) c->anim_frame = 0;
+}
+
+/* Render an SVG rotated about the centre of its viewBox - the icon has two-fold symmetry, so a half turn is a full cycle */
+static GdkPixbuf *render_frame (const char *svg, double angle, int width, int height)
+{
+    GdkPixbufLoader *loader;
+    GdkPixbuf *pixbuf = NULL;
+    const char *tag, *end, *vbox;
+    char ang[G_ASCII_DTOSTR_BUF_SIZE], cx[G_ASCII_DTOSTR_BUF_SIZE], cy[G_ASCII_DTOSTR_BUF_SIZE];
+    double vx = 0, vy = 0, vw = 32, vh = 32;
+    gchar *frame;
+
+    // wrap the contents of the root element in a rotated group
+    tag = strstr (svg, "<svg");
+    if (!tag || !(tag = strchr (tag, '>'))) return NULL;
+    if (!(end = g_strrstr (tag, "</svg>"))) return NULL;
+
+    vbox = strstr (svg, "viewBox=\"");
+    if (vbox && vbox < tag)
+    {
+        vbox += 9;
+        vx = g_ascii_strtod (vbox, (gchar **) &vbox);
+        vy = g_ascii_strtod (vbox, (gchar **) &vbox);
+        vw = g_ascii_strtod (vbox, (gchar **) &vbox);
+        vh = g_ascii_strtod (vbox, NULL);
+    }
+
+    g_ascii_formatd (ang, sizeof (ang), "%g", angle);
+    g_ascii_formatd (cx, sizeof (cx), "%g", vx + vw / 2);
+    g_ascii_formatd (cy, sizeof (cy), "%g", vy + vh / 2);
+    frame = g_strdup_printf ("%.*s<g transform=\"rotate(%s %s %s)\">%.*s</g>%s", (int) (tag + 1 - svg), svg,
+        ang, cx, cy, (int) (end - tag - 1), tag + 1, end);
+
+    loader = gdk_pixbuf_loader_new ();
+    gdk_pixbuf_loader_set_size (loader, width, height);
+    if (gdk_pixbuf_loader_write (loader, (const guchar *) frame, strlen (frame), NULL) && gdk_pixbuf_loader_close (loader, NULL))
     {
-        if (clear && c->anim[count]) g_object_unref (c->anim[count]);
-        iname = g_strdup_printf ("rpc-active%d", count);
-        c->anim[count] = wrap_load_taskbar_pixbuf (c, c->tray_icon, iname);
-        g_free (iname);
+        pixbuf = gdk_pixbuf_loader_get_pixbuf (loader);
+        if (pixbuf) g_object_ref (pixbuf);
     }
+    else gdk_pixbuf_loader_close (loader, NULL);
+    g_object_unref (loader);
+    g_free (frame);
+
+    return pixbuf;
+}
+
+static void set_timer (ConnectPlugin *c)
+{
+    if (c->icon_timer && c->timer_time == c->anim_time) return;
+
+    if (c->icon_timer) g_source_remove (c->icon_timer);
+    c->icon_timer = g_timeout_add (c->anim_time, G_SOURCE_FUNC (animate), c);
+    c->timer_time = c->anim_time;
+}
+
+/* Log time since init for each startup phase, until the first correct icon */
+static void startup_phase (ConnectPlugin *c, const char *phase)
+{
+    if (c->started) return;
+    DEBUG ("Startup - %s at %d ms", phase, MSECS (c->init_time));
+}
+
+/* The icon is correct once the frames are loaded and the state of the service is known */
+static void check_started (ConnectPlugin *c)
+{
+    if (c->started || !c->icons_loaded || !c->state_known) return;
+    c->startup_ms = MSECS (c->init_time);
+    startup_phase (c, "first correct icon");
+    c->started = TRUE;
 }
 
 /*----------------------------------------------------------------------------*/
@@ -446,8 +874,12 @@ static void connect_button_press_event (GtkButton *, ConnectPlugin *c)
 /* Handler for system config changed message from panel */
 void connect_update_display (ConnectPlugin *c)
 {
-    cache_animation (c, TRUE);
+    set_timer (c);
+    cache_animation (c);
     update_icon (c);
+    c->icons_loaded = TRUE;
+    startup_phase (c, "icons loaded");
+    check_started (c);
 }
 
 /* Handler for control message */
@@ -467,14 +899,22 @@ gboolean connect_control_msg (ConnectPlugin *c, const char *cmd)
         return TRUE;
     }
 
+    if (!strncmp (cmd, "profile", 7)) return handle_profile (c, cmd + 7);
+
     return FALSE;
 }
 
 void connect_init (ConnectPlugin *c)
 {
+    c->init_time = g_get_monotonic_time ();
+    c->started = FALSE;
+    c->icons_loaded = FALSE;
+    c->state_known = FALSE;
+
     setlocale (LC_ALL, "");
     bindtextdomain (GETTEXT_PACKAGE, PACKAGE_LOCALE_DIR);
     bind_textdomain_codeset (GETTEXT_PACKAGE, "UTF-8");
+    startup_phase (c, "locale bound");
 
     /* Allocate icon as a child of top level */
     c->tray_icon = gtk_image_new ();
@@ -489,30 +929,47 @@ void connect_init (ConnectPlugin *c)
 
     if (!access ("/usr/lib/systemd/user/rpi-connect.service", R_OK)) c->installed = TRUE;
     else c->installed = FALSE;
+    startup_phase (c, "install state probed");
 
     c->enabled = FALSE;
     c->enabling = FALSE;
-
-    /* Cache animation */
-    cache_animation (c, FALSE);
+    c->notify_id = 0;
+    c->notify_busy = FALSE;
+    c->notify_dirty = FALSE;
+    c->have_status = FALSE;
+    c->prof_vnc = -1;
+    c->prof_ssh = -1;
+    c->prof_calls = 0;
+    c->cancellable = g_cancellable_new ();
 
     /* Set up callbacks to see if Connect is on DBus */
     c->watch = g_bus_watch_name (G_BUS_TYPE_SESSION, "com.raspberrypi.Connect", 0,
         (GBusNameAppearedCallback) cb_name_owned, (GBusNameVanishedCallback) cb_name_unowned, c, NULL);
+    startup_phase (c, "bus watch added");
 
-    c->icon_timer = g_timeout_add (ANIM_TIME, G_SOURCE_FUNC (animate), c);
+    set_timer (c);
 }
 
 void connect_destructor (ConnectPlugin *c)
 {
-    int count;
-
     g_bus_unwatch_name (c->watch);
 
+    // stop any outstanding calls from calling back into the freed plugin
+    g_cancellable_cancel (c->cancellable);
+    g_object_unref (c->cancellable);
+
+    // a new instance can't learn the id of an existing notification, so withdraw it now
+    if (c->proxy && c->notify_id) close_notification (c, g_dbus_proxy_get_connection (c->proxy));
+
+    if (c->proxy)
+    {
+        g_signal_handlers_disconnect_by_data (c->proxy, c);
+        g_object_unref (c->proxy);
+    }
+
     if (c->icon_timer) g_source_remove (c->icon_timer);
 
-    for (count = 0; count < ANIM_FRAMES; count++)
-        if (c->anim[count]) g_object_unref (c->anim[count]);
+    clear_animation (c);
 
     g_free (c);
 }
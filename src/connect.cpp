@@ -40,12 +40,16 @@ extern "C" {
 
 void WayfireConnect::read_settings (void)
 {
+    c->icon_size = icon_size;
     c->animate = animate_icon;
+    c->anim_frames = CLAMP ((int) anim_frames, 1, 32);
+    c->anim_time = CLAMP ((int) anim_time, 50, 5000);
 }
 
 void WayfireConnect::settings_changed_cb (void)
 {
     read_settings ();
+    connect_update_display (c);
 }
 
 void WayfireConnect::command (const char *cmd)
@@ -79,7 +83,10 @@ void WayfireConnect::init (Gtk::HBox *container)
     connect_init (c);
 
     /* Setup callbacks */
+    icon_size.set_callback (sigc::mem_fun (*this, &WayfireConnect::settings_changed_cb));
     animate_icon.set_callback (sigc::mem_fun (*this, &WayfireConnect::settings_changed_cb));
+    anim_frames.set_callback (sigc::mem_fun (*this, &WayfireConnect::settings_changed_cb));
+    anim_time.set_callback (sigc::mem_fun (*this, &WayfireConnect::settings_changed_cb));
 }
 
 WayfireConnect::~WayfireConnect()
@@ -31,8 +31,6 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #define PLUGIN_TITLE N_("Connect")
 
-#define ANIM_FRAMES 8
-
 typedef struct
 {
     GtkWidget *plugin;              /* Back pointer to the widget */
@@ -42,6 +40,7 @@ typedef struct
 
     guint watch;
     GDBusProxy *proxy;
+    GCancellable *cancellable;      /* Cancels outstanding calls on destruction */
 
     gboolean installed;
     gboolean enabled;
@@ -52,10 +51,31 @@ typedef struct
     gboolean ssh_on;
     int vnc_sess_count;
     int ssh_sess_count;
+    gboolean have_status;           /* Baseline status received since the service appeared */
+    guint32 notify_id;              /* Desktop notification to replace, 0 if none */
+    gboolean notify_busy;
+    gboolean notify_dirty;
+    gint64 notify_time;
+    int prof_vnc;                   /* Pending profile settings, -1 if unchanged */
+    int prof_ssh;
+    int prof_calls;                 /* Profile calls still in flight */
+    gint64 prof_time;
+    gint64 init_time;               /* Startup timing */
+    gboolean icons_loaded;
+    gboolean state_known;
+    gboolean started;
+    int startup_ms;                 /* Time from init to the first correct icon */
     int icon_timer;
+    int timer_time;
     int anim_frame;
     gboolean animate;
-    GdkPixbuf *anim[ANIM_FRAMES];
+    int icon_size;                  /* Panel icon size setting */
+    int anim_frames;                /* Configured frame count and interval */
+    int anim_time;
+    GdkPixbuf **anim;               /* Generated frames, cached for one icon size */
+    int anim_count;
+    int anim_size;                  /* Panel icon size the cache was generated for */
+    int anim_req;                   /* Frame count the cache was generated for */
 } ConnectPlugin;
 
 extern conf_table_t conf_table[2];
@@ -44,7 +44,10 @@ class WayfireConnect : public WayfireWidget
 
     sigc::connection icon_timer;
 
+    WfOption <int> icon_size {"panel/icon_size"};
     WfOption <bool> animate_icon {"panel/connect_animate_icon"};
+    WfOption <int> anim_frames {"panel/connect_anim_frames"};
+    WfOption <int> anim_time {"panel/connect_anim_time"};
 
     /* plugin */
     ConnectPlugin *c;
@@ -0,0 +1,260 @@
+/*============================================================================
+Copyright (c) 2024-2025 Raspberry Pi
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the copyright holder nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+============================================================================*/
+
+/* Adds the connect widget to the panel configuration of every user with a
+ * login shell - called from the package postinst.
+ *
+ * Usage: wfplug-connect-migrate [-p passwd] [-r root] [-j threads]
+ * -p reads users from a passwd format file rather than the system database;
+ * -r prefixes /etc/shells and home directories with an alternate root. */
+
+#include <pwd.h>
+#include <getopt.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#include <atomic>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <random>
+#include <string>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+#define CONFIG_DIR  ".config"
+#define INI_FILE    "wf-panel-pi.ini"
+#define WIDGET      "connect"
+#define MAX_THREADS 8
+
+/*----------------------------------------------------------------------------*/
+/* Helpers                                                                    */
+/*----------------------------------------------------------------------------*/
+
+static std::unordered_set <std::string> read_shells (const std::string &root)
+{
+    std::unordered_set <std::string> shells;
+    std::ifstream file (root + "/etc/shells");
+    std::string line;
+
+    while (std::getline (file, line))
+    {
+        if (line.empty () || line[0] == '#') continue;
+        shells.insert (line);
+    }
+    return shells;
+}
+
+static bool is_word_char (char ch)
+{
+    return isalnum ((unsigned char) ch) || ch == '_';
+}
+
+/* Equivalent of grep -w - the widget name not bordered by word characters */
+static bool has_widget (const std::string &data)
+{
+    size_t pos = 0, len = strlen (WIDGET);
+
+    while ((pos = data.find (WIDGET, pos)) != std::string::npos)
+    {
+        if ((pos == 0 || !is_word_char (data[pos - 1]))
+            && (pos + len == data.size () || !is_word_char (data[pos + len]))) return true;
+        pos++;
+    }
+    return false;
+}
+
+/* Equivalent of sed -e '/^widgets_right/ s/$/ connect/' - returns false if no line matched */
+static bool add_widget (const std::string &data, std::string &out)
+{
+    bool found = false;
+    size_t start = 0, end;
+
+    out.reserve (data.size () + strlen (WIDGET) + 1);
+    while (start < data.size ())
+    {
+        end = data.find ('\n', start);
+        if (end == std::string::npos) end = data.size ();
+        out.append (data, start, end - start);
+        if (!data.compare (start, 13, "widgets_right"))
+        {
+            out += " " WIDGET;
+            found = true;
+        }
+        if (end < data.size ()) out += '\n';
+        start = end + 1;
+    }
+    return found;
+}
+
+/* Write the new contents alongside the original and rename over it, keeping its owner and mode.
+ * Everything is relative to the already opened directory, so nothing in the user's home is
+ * resolved by path again. */
+static bool replace_file (int dir_fd, const std::string &data, const struct stat &st)
+{
+    static thread_local std::mt19937 rng (std::random_device {} ());
+    char tmp[64];
+    int fd = -1, tries;
+    bool ok;
+
+    for (tries = 0; tries < 16 && fd < 0; tries++)
+    {
+        snprintf (tmp, sizeof (tmp), "%s.%08x", INI_FILE, (unsigned int) rng ());
+        fd = openat (dir_fd, tmp, O_WRONLY | O_CREAT | O_EXCL | O_NOFOLLOW | O_CLOEXEC, 0600);
+        if (fd < 0 && errno != EEXIST) return false;
+    }
+    if (fd < 0) return false;
+
+    ok = write (fd, data.data (), data.size ()) == (ssize_t) data.size ()
+        && !fchown (fd, st.st_uid, st.st_gid)
+        && !fchmod (fd, st.st_mode & 07777)
+        && !fsync (fd);
+    if (close (fd)) ok = false;
+
+    if (ok && !renameat (dir_fd, tmp, dir_fd, INI_FILE)) return true;
+
+    unlinkat (dir_fd, tmp, 0);
+    return false;
+}
+
+/* Add the widget to the ini file in an opened .config directory - only a plain file with a single link is touched */
+static bool update_ini (int dir_fd)
+{
+    std::string data, out;
+    struct stat st;
+    char buf[4096];
+    ssize_t len;
+    int fd;
+
+    fd = openat (dir_fd, INI_FILE, O_RDONLY | O_NOFOLLOW | O_NONBLOCK | O_CLOEXEC);
+    if (fd < 0) return true;
+    if (fstat (fd, &st) || !S_ISREG (st.st_mode) || st.st_nlink != 1)
+    {
+        close (fd);
+        return true;
+    }
+    while ((len = read (fd, buf, sizeof (buf))) > 0) data.append (buf, len);
+    close (fd);
+    if (len < 0) return false;
+
+    if (has_widget (data)) return true;
+    if (!add_widget (data, out)) return true;
+
+    return replace_file (dir_fd, out, st);
+}
+
+static void process_home (const std::string &home)
+{
+    int home_fd, dir_fd;
+
+    // the home directory comes from the password database; below it the user controls every
+    // name, so .config and the ini file are opened without following links
+    home_fd = open (home.c_str (), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (home_fd < 0) return;
+    dir_fd = openat (home_fd, CONFIG_DIR, O_RDONLY | O_DIRECTORY | O_NOFOLLOW | O_CLOEXEC);
+    close (home_fd);
+    if (dir_fd < 0) return;
+
+    if (!update_ini (dir_fd))
+        fprintf (stderr, "wfplug-connect-migrate: failed to update %s/" CONFIG_DIR "/" INI_FILE "\n", home.c_str ());
+    close (dir_fd);
+}
+
+/*----------------------------------------------------------------------------*/
+/* Main function                                                              */
+/*----------------------------------------------------------------------------*/
+
+int main (int argc, char *argv[])
+{
+    std::unordered_set <std::string> shells, seen;
+    std::vector <std::string> homes;
+    std::vector <std::thread> workers;
+    std::atomic <size_t> next (0);
+    std::string root;
+    const char *pwfile = NULL;
+    struct passwd *pw;
+    FILE *fp = NULL;
+    unsigned int count = 0;
+    int opt;
+
+    while ((opt = getopt (argc, argv, "p:r:j:")) != -1)
+    {
+        switch (opt)
+        {
+            case 'p' :  pwfile = optarg;
+                        break;
+            case 'r' :  root = optarg;
+                        break;
+            case 'j' :  count = atoi (optarg);
+                        break;
+            default :   fprintf (stderr, "Usage: %s [-p passwd] [-r root] [-j threads]\n", argv[0]);
+                        return 1;
+        }
+    }
+
+    if (pwfile && !(fp = fopen (pwfile, "r")))
+    {
+        fprintf (stderr, "wfplug-connect-migrate: cannot read %s\n", pwfile);
+        return 1;
+    }
+
+    // enumerate users once, keeping each home directory of a user with a valid login shell
+    shells = read_shells (root);
+    if (!fp) setpwent ();
+    while ((pw = fp ? fgetpwent (fp) : getpwent ()))
+    {
+        // an empty shell field means /bin/sh
+        if (!shells.count (pw->pw_shell[0] ? pw->pw_shell : "/bin/sh")) continue;
+        if (!pw->pw_dir[0] || !seen.insert (pw->pw_dir).second) continue;
+        homes.emplace_back (root + pw->pw_dir);
+    }
+    if (fp) fclose (fp);
+    else endpwent ();
+
+    if (count < 1) count = std::thread::hardware_concurrency ();
+    if (count < 1) count = 1;
+    if (count > MAX_THREADS) count = MAX_THREADS;
+    if (count > homes.size ()) count = homes.size ();
+
+    for (unsigned int i = 0; i < count; i++)
+    {
+        workers.emplace_back ([&] {
+            size_t index;
+            while ((index = next++) < homes.size ()) process_home (homes[index]);
+        });
+    }
+    for (auto &worker : workers) worker.join ();
+
+    return 0;
+}
+
+/* End of file */
+/*----------------------------------------------------------------------------*/
@@ -0,0 +1,133 @@
+/*============================================================================
+Copyright (c) 2025 Raspberry Pi
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the copyright holder nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+============================================================================*/
+
+/* Animation load benchmark - time and resident memory to load the animation
+ * frames, either generated from the SVG source or as per-frame icon files.
+ *
+ * Usage: bench-anim svg|files icon-dir [size] [frames]
+ * "files" loads rpc-active0... from a theme containing the per-frame icons. */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "lxutils.h"
+#include "connect.h"
+
+/*----------------------------------------------------------------------------*/
+/* Typedefs and macros                                                        */
+/*----------------------------------------------------------------------------*/
+
+#define SKIP_EXIT_CODE  77
+
+/*----------------------------------------------------------------------------*/
+/* Function definitions                                                       */
+/*----------------------------------------------------------------------------*/
+
+static long rss_kb (void)
+{
+    char *status, *line;
+    long val = -1;
+
+    if (!g_file_get_contents ("/proc/self/status", &status, NULL, NULL)) return -1;
+    line = strstr (status, "VmRSS:");
+    if (line) val = atol (line + 6);
+    g_free (status);
+    return val;
+}
+
+int main (int argc, char *argv[])
+{
+    ConnectPlugin *c;
+    GdkPixbuf **frames;
+    gint64 start;
+    long rss;
+    int count, frame_count, elapsed, loaded = 0;
+
+    if (argc < 3 || (strcmp (argv[1], "svg") && strcmp (argv[1], "files")))
+    {
+        fprintf (stderr, "Usage: %s svg|files icon-dir [size] [frames]\n", argv[0]);
+        return 1;
+    }
+    if (argc > 3) mock_icon_size = atoi (argv[3]);
+    frame_count = argc > 4 ? atoi (argv[4]) : 8;
+
+    g_setenv ("NO_AT_BRIDGE", "1", TRUE);
+    if (!gtk_init_check (&argc, &argv))
+    {
+        fprintf (stderr, "No display available - skipping\n");
+        return SKIP_EXIT_CODE;
+    }
+
+    // scan the theme before measuring, as the panel will already have done so
+    gtk_icon_theme_prepend_search_path (gtk_icon_theme_get_default (), argv[2]);
+    gtk_icon_theme_has_icon (gtk_icon_theme_get_default (), "rpc-enabled");
+
+    c = g_new0 (ConnectPlugin, 1);
+    c->plugin = gtk_button_new ();
+    c->tray_icon = gtk_image_new ();
+    c->icon_size = mock_icon_size;
+    c->anim_frames = frame_count;
+    c->anim_time = 500;
+
+    rss = rss_kb ();
+    start = g_get_monotonic_time ();
+    if (!strcmp (argv[1], "svg"))
+    {
+        connect_update_display (c);
+        loaded = c->anim_count;
+    }
+    else
+    {
+        frames = g_new0 (GdkPixbuf *, frame_count);
+        for (count = 0; count < frame_count; count++)
+        {
+            char *iname = g_strdup_printf ("rpc-active%d", count);
+            frames[count] = mock_load_taskbar_pixbuf (c->tray_icon, iname);
+            if (frames[count]) loaded++;
+            g_free (iname);
+        }
+    }
+    elapsed = g_get_monotonic_time () - start;
+
+    printf ("%-5s %d/%d frames at %d px: %6.2f ms, RSS +%ld kB\n", argv[1], loaded, frame_count, mock_icon_size,
+        elapsed / 1000.0, rss_kb () - rss);
+
+    // the panel redraws on every settings change - at the same size the cached frames are reused
+    if (!strcmp (argv[1], "svg"))
+    {
+        mock_icon_loads = 0;
+        start = g_get_monotonic_time ();
+        connect_update_display (c);
+        elapsed = g_get_monotonic_time () - start;
+        printf ("%-5s redraw at the same size: %6.2f ms, %d icons loaded\n", argv[1], elapsed / 1000.0, mock_icon_loads);
+    }
+    return loaded == frame_count ? 0 : 1;
+}
+
+/* End of file */
+/*----------------------------------------------------------------------------*/
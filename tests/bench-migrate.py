@@ -0,0 +1,138 @@
+#!/usr/bin/env python3
+#
+# Generates a synthetic passwd file and home tree, runs the panel config
+# migration helper over it and checks the result.
+#
+# Usage: bench-migrate.py helper [--users N] [--shell-loop]
+#
+# --shell-loop also times the per-user shell loop the helper replaced, on a
+# second copy of the same tree.
+#
+# Some users have .config, or the ini file itself, linked to a file outside
+# their home; the helper must leave those files alone.
+
+import argparse
+import os
+import shutil
+import subprocess
+import sys
+import tempfile
+import time
+
+SHELLS = [ "/bin/sh", "/bin/bash", "/usr/bin/bash", "/bin/dash" ]
+INI = "[panel]\nwidgets_left=smenu spacing4 launchers\nwidgets_right=tray spacing4 volumepulse clock{}\n"
+
+SHELL_LOOP = r'''
+while read line
+do
+    USHELL=$(echo "$line" | cut -d: -f7)
+    if grep -q "$USHELL" "$ROOT/etc/shells" ; then
+      HOME_DIR=$ROOT$(echo "$line" | cut -d: -f6)/
+      if [ -e "$HOME_DIR/.config/wf-panel-pi.ini" ] ; then
+        if ! grep -q -w connect "$HOME_DIR/.config/wf-panel-pi.ini" ; then
+          sed "$HOME_DIR/.config/wf-panel-pi.ini" -i -e '/^widgets_right/ s/$/ connect/'
+        fi
+      fi
+    fi
+done < "$ROOT/etc/passwd"
+'''
+
+# Each user falls into one of these cases, by index
+def user_kind (n):
+    if n % 10 == 0: return "nologin"
+    if n % 10 == 1: return "noconfig"
+    if n % 10 == 2: return "present"
+    if n % 50 == 3: return "linkdir"
+    if n % 50 == 13: return "linkfile"
+    return "add"
+
+# Links planted by a user point at files outside their home, which must not change
+LINKED = ("linkdir", "linkfile")
+
+def generate (root, users):
+    os.makedirs (os.path.join (root, "etc"))
+    with open (os.path.join (root, "etc", "shells"), "w") as f:
+        f.write ("# /etc/shells: valid login shells\n" + "\n".join (SHELLS) + "\n")
+
+    with open (os.path.join (root, "etc", "passwd"), "w") as pw:
+        for n in range (users):
+            kind = user_kind (n)
+            shell = "/usr/sbin/nologin" if kind == "nologin" else SHELLS[n % len (SHELLS)]
+            home = "/home/user{}".format (n)
+            pw.write ("user{0}:x:{1}:{1}::{2}:{3}\n".format (n, 10000 + n, home, shell))
+            if kind == "noconfig": continue
+            conf = os.path.join (root + home, ".config")
+            if kind in LINKED:
+                target = os.path.join (root, "outside", "user{}".format (n))
+                os.makedirs (target)
+                with open (os.path.join (target, "wf-panel-pi.ini"), "w") as f: f.write (INI.format (""))
+                if kind == "linkdir":
+                    os.makedirs (root + home)
+                    os.symlink (os.path.relpath (target, root + home), conf)
+                else:
+                    os.makedirs (conf)
+                    os.symlink (os.path.relpath (os.path.join (target, "wf-panel-pi.ini"), conf), os.path.join (conf, "wf-panel-pi.ini"))
+                continue
+            os.makedirs (conf)
+            with open (os.path.join (conf, "wf-panel-pi.ini"), "w") as f:
+                f.write (INI.format (" connect" if kind == "present" else ""))
+
+def check (root, users, linked = True):
+    errors = 0
+    for n in range (users):
+        kind = user_kind (n)
+        if kind == "noconfig": continue
+        if kind in LINKED and not linked: continue
+        if kind in LINKED:
+            path = os.path.join (root, "outside", "user{}".format (n), "wf-panel-pi.ini")
+            if os.listdir (os.path.dirname (path)) != [ "wf-panel-pi.ini" ]:
+                errors += 1
+                if errors <= 5: print ("user{}: files created outside home".format (n), file = sys.stderr)
+        else: path = os.path.join (root, "home", "user{}".format (n), ".config", "wf-panel-pi.ini")
+        with open (path) as f:
+            data = f.read ()
+        expected = INI.format (" connect" if kind in ("present", "add") else "")
+        if data != expected:
+            errors += 1
+            if errors <= 5: print ("user{}: unexpected contents\n{}".format (n, data), file = sys.stderr)
+    return errors
+
+def timed (cmd, **kwargs):
+    start = time.monotonic ()
+    subprocess.run (cmd, check = True, **kwargs)
+    return time.monotonic () - start
+
+def main ():
+    parser = argparse.ArgumentParser ()
+    parser.add_argument ("helper")
+    parser.add_argument ("--users", type = int, default = 50000)
+    parser.add_argument ("--shell-loop", action = "store_true")
+    args = parser.parse_args ()
+
+    with tempfile.TemporaryDirectory () as tmp:
+        root = os.path.join (tmp, "helper")
+        generate (root, args.users)
+        if args.shell_loop: shutil.copytree (root, os.path.join (tmp, "loop"), symlinks = True)
+
+        elapsed = timed ([ args.helper, "-p", os.path.join (root, "etc", "passwd"), "-r", root ])
+        print ("helper: {} users in {:.3f} s".format (args.users, elapsed))
+        errors = check (root, args.users)
+
+        # a second run must leave everything untouched
+        timed ([ args.helper, "-p", os.path.join (root, "etc", "passwd"), "-r", root ])
+        errors += check (root, args.users)
+
+        if args.shell_loop:
+            loop = os.path.join (tmp, "loop")
+            elapsed = timed ([ "sh", "-c", SHELL_LOOP ], env = dict (os.environ, ROOT = loop))
+            print ("shell loop: {} users in {:.3f} s".format (args.users, elapsed))
+            # the shell loop followed links, so only the ordinary cases are compared
+            errors += check (loop, args.users, linked = False)
+
+    if errors:
+        print ("{} files incorrect".format (errors), file = sys.stderr)
+        return 1
+    return 0
+
+if __name__ == "__main__":
+    sys.exit (main ())
@@ -0,0 +1,34 @@
+#!/bin/sh
+#
+# Compares loading the animation frames from the single SVG source with
+# loading the per-frame icon files that were shipped before, taken from the
+# git history of this tree.
+#
+# Usage: compare-anim.sh bench-anim [size] [runs]
+# Needs a display - for example, run under xvfb-run.
+
+set -e
+
+BENCH="$1"
+SIZE="${2:-24}"
+RUNS="${3:-5}"
+SRC="$(cd "$(dirname "$0")/.." && pwd)"
+
+# the commit which removed the per-frame icons
+REV="$(git -C "$SRC" rev-list -1 HEAD -- data/icons/hicolor/scalable/status/rpc-active1.svg)"
+if [ -z "$REV" ] ; then
+  echo "per-frame icons not found in git history" >&2
+  exit 1
+fi
+
+TMP="$(mktemp -d)"
+trap 'rm -rf "$TMP"' EXIT
+git -C "$SRC" archive "$REV^" data/icons | tar -x -C "$TMP"
+
+i=0
+while [ "$i" -lt "$RUNS" ]
+do
+  "$BENCH" files "$TMP/data/icons" "$SIZE"
+  "$BENCH" svg "$SRC/data/icons" "$SIZE"
+  i=$((i + 1))
+done
@@ -0,0 +1,325 @@
+/*============================================================================
+Copyright (c) 2025 Raspberry Pi
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the copyright holder nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+============================================================================*/
+
+/* Test harness - runs the plugin against mock Connect and notification
+ * services on a private session bus. */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "harness.h"
+
+/*----------------------------------------------------------------------------*/
+/* Typedefs and macros                                                        */
+/*----------------------------------------------------------------------------*/
+
+#define CONNECT_NAME    "com.raspberrypi.Connect"
+#define CONNECT_PATH    "/com/raspberrypi/Connect"
+#define NOTIFY_NAME     "org.freedesktop.Notifications"
+#define NOTIFY_PATH     "/org/freedesktop/Notifications"
+
+#define SKIP_EXIT_CODE  77
+
+/*----------------------------------------------------------------------------*/
+/* Global data                                                                */
+/*----------------------------------------------------------------------------*/
+
+MockConnect mock_connect;
+MockNotify mock_notify;
+
+static GTestDBus *bus;
+static GDBusConnection *mock_conn;
+static guint connect_owner, notify_owner;
+static guint32 next_id;
+
+static const char introspection[] =
+    "<node>"
+    "  <interface name='" CONNECT_NAME "'>"
+    "    <method name='Status'><arg type='(bbbbii)' direction='out'/></method>"
+    "    <method name='SignIn'/>"
+    "    <method name='SignOut'/>"
+    "    <method name='VncOn'/>"
+    "    <method name='VncOff'/>"
+    "    <method name='ShellOn'/>"
+    "    <method name='ShellOff'/>"
+    "    <signal name='Status'><arg type='(bbbbii)'/></signal>"
+    "  </interface>"
+    "  <interface name='" NOTIFY_NAME "'>"
+    "    <method name='Notify'>"
+    "      <arg type='s' direction='in'/>"
+    "      <arg type='u' direction='in'/>"
+    "      <arg type='s' direction='in'/>"
+    "      <arg type='s' direction='in'/>"
+    "      <arg type='s' direction='in'/>"
+    "      <arg type='as' direction='in'/>"
+    "      <arg type='a{sv}' direction='in'/>"
+    "      <arg type='i' direction='in'/>"
+    "      <arg type='u' direction='out'/>"
+    "    </method>"
+    "    <method name='CloseNotification'><arg type='u' direction='in'/></method>"
+    "  </interface>"
+    "</node>";
+
+/*----------------------------------------------------------------------------*/
+/* Prototypes                                                                 */
+/*----------------------------------------------------------------------------*/
+
+static GVariant *status_value (void);
+static void connect_method (GDBusConnection *, const gchar *, const gchar *, const gchar *, const gchar *method, GVariant *, GDBusMethodInvocation *inv, gpointer);
+static void notify_method (GDBusConnection *, const gchar *, const gchar *, const gchar *, const gchar *method, GVariant *params, GDBusMethodInvocation *inv, gpointer);
+static gboolean set_icon (gpointer data);
+static gboolean timed_out (gpointer data);
+static gboolean never (gpointer);
+
+/*----------------------------------------------------------------------------*/
+/* Function definitions                                                       */
+/*----------------------------------------------------------------------------*/
+
+/* Mock services */
+
+static GVariant *status_value (void)
+{
+    return g_variant_new ("((bbbbii))", mock_connect.signed_in, mock_connect.vnc_avail, mock_connect.vnc_on,
+        mock_connect.ssh_on, mock_connect.vnc_sess_count, mock_connect.ssh_sess_count);
+}
+
+static void connect_method (GDBusConnection *, const gchar *, const gchar *, const gchar *, const gchar *method, GVariant *, GDBusMethodInvocation *inv, gpointer)
+{
+    if (!g_strcmp0 (method, "Status"))
+    {
+        g_dbus_method_invocation_return_value (inv, status_value ());
+        return;
+    }
+
+    mock_connect.calls++;
+    if (!g_strcmp0 (method, "SignIn")) mock_connect.signed_in = TRUE;
+    else if (!g_strcmp0 (method, "SignOut")) mock_connect.signed_in = FALSE;
+    else if (!g_strcmp0 (method, "VncOn")) mock_connect.vnc_on = TRUE;
+    else if (!g_strcmp0 (method, "VncOff")) mock_connect.vnc_on = FALSE;
+    else if (!g_strcmp0 (method, "ShellOn")) mock_connect.ssh_on = TRUE;
+    else if (!g_strcmp0 (method, "ShellOff")) mock_connect.ssh_on = FALSE;
+
+    // signal the new state before returning, so Status arrives while the caller still has calls outstanding
+    harness_emit_status ();
+    g_dbus_method_invocation_return_value (inv, NULL);
+}
+
+static void notify_method (GDBusConnection *, const gchar *, const gchar *, const gchar *, const gchar *method, GVariant *params, GDBusMethodInvocation *inv, gpointer)
+{
+    if (!g_strcmp0 (method, "Notify"))
+    {
+        mock_notify.notify_time = g_get_monotonic_time ();
+        g_variant_get_child (params, 1, "u", &mock_notify.last_replaces);
+        mock_notify.last_id = mock_notify.last_replaces ? mock_notify.last_replaces : ++next_id;
+        mock_notify.notify_count++;
+        g_dbus_method_invocation_return_value (inv, g_variant_new ("(u)", mock_notify.last_id));
+    }
+    else
+    {
+        g_variant_get (params, "(u)", &mock_notify.closed_id);
+        mock_notify.close_count++;
+        g_dbus_method_invocation_return_value (inv, NULL);
+    }
+}
+
+void harness_connect_up (void)
+{
+    connect_owner = g_bus_own_name_on_connection (mock_conn, CONNECT_NAME, G_BUS_NAME_OWNER_FLAGS_NONE, NULL, NULL, NULL, NULL);
+}
+
+void harness_connect_down (void)
+{
+    if (connect_owner) g_bus_unown_name (connect_owner);
+    connect_owner = 0;
+}
+
+void harness_emit_status (void)
+{
+    g_dbus_connection_emit_signal (mock_conn, NULL, CONNECT_PATH, CONNECT_NAME, "Status", status_value (), NULL);
+    g_dbus_connection_flush_sync (mock_conn, NULL, NULL);
+}
+
+/* Host commands - answered from the mock state, so that results don't depend on the machine running the tests */
+
+int system (const char *command)
+{
+    if (!command) return 1;
+    if (g_str_has_prefix (command, "dpkg -l ")) return mock_connect.installed ? 0 : 1;
+    if (g_str_has_prefix (command, "systemctl --user -q is-active ")) return mock_connect.enabled ? 0 : 1;
+    if (!strcmp (command, "rpi-connect on")) mock_connect.enabled = TRUE;
+    else if (!strcmp (command, "rpi-connect off")) mock_connect.enabled = FALSE;
+    return 0;
+}
+
+/* Plugin setup - as WayfireConnect::init */
+
+static gboolean set_icon (gpointer data)
+{
+    connect_update_display ((ConnectPlugin *) data);
+    return FALSE;
+}
+
+ConnectPlugin *harness_plugin_new (void)
+{
+    ConnectPlugin *c = g_new0 (ConnectPlugin, 1);
+
+    c->plugin = gtk_button_new ();
+    g_object_ref_sink (c->plugin);
+    g_idle_add (set_icon, c);
+
+    c->animate = TRUE;
+    c->icon_size = mock_icon_size;
+    c->anim_frames = 8;
+    c->anim_time = 500;
+    connect_init (c);
+    return c;
+}
+
+void harness_plugin_free (ConnectPlugin *c)
+{
+    GtkWidget *plugin = c->plugin;
+
+    g_idle_remove_by_data (c);
+    connect_destructor (c);
+    gtk_widget_destroy (plugin);
+    g_object_unref (plugin);
+}
+
+/* Main loop helpers */
+
+static gboolean timed_out (gpointer data)
+{
+    *((gboolean *) data) = TRUE;
+    return FALSE;
+}
+
+static gboolean never (gpointer)
+{
+    return FALSE;
+}
+
+gboolean harness_wait (HarnessCond cond, gpointer data, int timeout_ms)
+{
+    gboolean expired = FALSE;
+    guint timer = g_timeout_add (timeout_ms, timed_out, &expired);
+
+    while (!cond (data) && !expired) g_main_context_iteration (NULL, TRUE);
+
+    if (!expired) g_source_remove (timer);
+    return cond (data);
+}
+
+void harness_run (int ms)
+{
+    harness_wait (never, NULL, ms);
+}
+
+int harness_budget (const char *var, int def)
+{
+    const char *val = g_getenv (var);
+
+    if (val && *val) return atoi (val);
+    return def;
+}
+
+/* Setup and teardown */
+
+void harness_reset (void)
+{
+    memset (&mock_connect, 0, sizeof (mock_connect));
+    memset (&mock_notify, 0, sizeof (mock_notify));
+    mock_connect.installed = TRUE;
+    mock_connect.enabled = TRUE;
+    mock_connect.signed_in = TRUE;
+    mock_connect.vnc_avail = TRUE;
+    mock_icon = NULL;
+    mock_icon_sets = 0;
+    mock_icon_loads = 0;
+    mock_icon_size = 24;
+}
+
+void harness_init (int *argc, char ***argv)
+{
+    static const GDBusInterfaceVTable connect_vtable = { connect_method, NULL, NULL, { 0 } };
+    static const GDBusInterfaceVTable notify_vtable = { notify_method, NULL, NULL, { 0 } };
+    GDBusNodeInfo *info;
+    GError *error = NULL;
+
+    gchar *daemon;
+
+    g_test_init (argc, argv, NULL);
+    g_setenv ("NO_AT_BRIDGE", "1", TRUE);
+    g_setenv ("GSETTINGS_BACKEND", "memory", TRUE);
+
+    // skip rather than fail where the test environment is incomplete
+    daemon = g_find_program_in_path ("dbus-daemon");
+    if (!daemon)
+    {
+        g_printerr ("No dbus-daemon available - skipping\n");
+        exit (SKIP_EXIT_CODE);
+    }
+    g_free (daemon);
+    if (!gtk_init_check (argc, argv))
+    {
+        g_printerr ("No display available - skipping\n");
+        exit (SKIP_EXIT_CODE);
+    }
+
+    // private session bus for both the plugin and the mock services
+    bus = g_test_dbus_new (G_TEST_DBUS_NONE);
+    g_test_dbus_up (bus);
+
+    gtk_icon_theme_prepend_search_path (gtk_icon_theme_get_default (), TEST_ICON_DIR);
+
+    // the mocks use their own connection, so the plugin sees them as a separate peer
+    mock_conn = g_dbus_connection_new_for_address_sync (g_test_dbus_get_bus_address (bus),
+        G_DBUS_CONNECTION_FLAGS_AUTHENTICATION_CLIENT | G_DBUS_CONNECTION_FLAGS_MESSAGE_BUS_CONNECTION, NULL, NULL, &error);
+    g_assert_no_error (error);
+
+    info = g_dbus_node_info_new_for_xml (introspection, &error);
+    g_assert_no_error (error);
+    g_dbus_connection_register_object (mock_conn, CONNECT_PATH, info->interfaces[0], &connect_vtable, NULL, NULL, &error);
+    g_assert_no_error (error);
+    g_dbus_connection_register_object (mock_conn, NOTIFY_PATH, info->interfaces[1], &notify_vtable, NULL, NULL, &error);
+    g_assert_no_error (error);
+    g_dbus_node_info_unref (info);
+
+    notify_owner = g_bus_own_name_on_connection (mock_conn, NOTIFY_NAME, G_BUS_NAME_OWNER_FLAGS_NONE, NULL, NULL, NULL, NULL);
+    harness_reset ();
+}
+
+void harness_cleanup (void)
+{
+    harness_connect_down ();
+    if (notify_owner) g_bus_unown_name (notify_owner);
+    if (mock_conn) g_object_unref (mock_conn);
+    g_test_dbus_down (bus);
+    g_object_unref (bus);
+}
+
+/* End of file */
+/*----------------------------------------------------------------------------*/
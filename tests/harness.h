@@ -0,0 +1,93 @@
+/*============================================================================
+Copyright (c) 2025 Raspberry Pi
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the copyright holder nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+============================================================================*/
+
+#ifndef TESTS_HARNESS_H
+#define TESTS_HARNESS_H
+
+#include <gtk/gtk.h>
+
+#include "lxutils.h"
+#include "connect.h"
+
+/*----------------------------------------------------------------------------*/
+/* Typedefs and macros                                                        */
+/*----------------------------------------------------------------------------*/
+
+/* State reported by the mock Connect service, and by the host commands the plugin runs */
+typedef struct
+{
+    gboolean installed;
+    gboolean enabled;
+    gboolean signed_in;
+    gboolean vnc_avail;
+    gboolean vnc_on;
+    gboolean ssh_on;
+    int vnc_sess_count;
+    int ssh_sess_count;
+    int calls;                      /* Method calls other than Status */
+} MockConnect;
+
+/* Calls seen by the mock notification daemon */
+typedef struct
+{
+    int notify_count;
+    guint32 last_replaces;
+    guint32 last_id;
+    gint64 notify_time;
+    int close_count;
+    guint32 closed_id;
+} MockNotify;
+
+typedef gboolean (*HarnessCond) (gpointer data);
+
+/*----------------------------------------------------------------------------*/
+/* Global data                                                                */
+/*----------------------------------------------------------------------------*/
+
+extern MockConnect mock_connect;
+extern MockNotify mock_notify;
+
+/*----------------------------------------------------------------------------*/
+/* Prototypes                                                                 */
+/*----------------------------------------------------------------------------*/
+
+extern void harness_init (int *argc, char ***argv);
+extern void harness_cleanup (void);
+extern void harness_reset (void);
+extern void harness_connect_up (void);
+extern void harness_connect_down (void);
+extern void harness_emit_status (void);
+extern ConnectPlugin *harness_plugin_new (void);
+extern void harness_plugin_free (ConnectPlugin *c);
+extern gboolean harness_wait (HarnessCond cond, gpointer data, int timeout_ms);
+extern void harness_run (int ms);
+extern int harness_budget (const char *var, int def);
+
+#endif /* end of include guard: TESTS_HARNESS_H */
+
+/* End of file */
+/*----------------------------------------------------------------------------*/
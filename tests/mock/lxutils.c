@@ -0,0 +1,66 @@
+/*============================================================================
+Copyright (c) 2025 Raspberry Pi
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the copyright holder nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+============================================================================*/
+
+#include "lxutils.h"
+
+/*----------------------------------------------------------------------------*/
+/* Global data                                                                */
+/*----------------------------------------------------------------------------*/
+
+const char *mock_icon = NULL;
+int mock_icon_size = 24;
+int mock_icon_sets = 0;
+int mock_icon_loads = 0;
+
+/*----------------------------------------------------------------------------*/
+/* Function definitions                                                       */
+/*----------------------------------------------------------------------------*/
+
+void mock_set_taskbar_icon (GtkWidget *, const char *icon)
+{
+    mock_icon = g_intern_string (icon);
+    mock_icon_sets++;
+}
+
+GdkPixbuf *mock_load_taskbar_pixbuf (GtkWidget *, const char *icon)
+{
+    mock_icon_loads++;
+    return gtk_icon_theme_load_icon (gtk_icon_theme_get_default (), icon, mock_icon_size, GTK_ICON_LOOKUP_FORCE_SIZE, NULL);
+}
+
+void set_image_from_pixbuf (GtkWidget *, GdkPixbuf *)
+{
+    mock_icon = "frame";
+    mock_icon_sets++;
+}
+
+void show_menu_with_kbd (GtkWidget *, GtkWidget *)
+{
+}
+
+/* End of file */
+/*----------------------------------------------------------------------------*/
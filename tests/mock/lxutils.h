@@ -0,0 +1,83 @@
+/*============================================================================
+Copyright (c) 2025 Raspberry Pi
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the copyright holder nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+============================================================================*/
+
+/* Minimal stand-in for the wf-panel-pi utility header, so that the plugin
+ * can be built into a test program without the panel. Icons set on the
+ * tray image are recorded rather than displayed. */
+
+#ifndef MOCK_LXUTILS_H
+#define MOCK_LXUTILS_H
+
+#include <gtk/gtk.h>
+
+/*----------------------------------------------------------------------------*/
+/* Typedefs and macros                                                        */
+/*----------------------------------------------------------------------------*/
+
+typedef enum
+{
+    CONF_TYPE_NONE,
+    CONF_TYPE_BOOL,
+    CONF_TYPE_INT,
+    CONF_TYPE_STRING
+} conf_type_t;
+
+typedef struct
+{
+    conf_type_t type;
+    const char *name;
+    const char *label;
+    void *data;
+} conf_table_t;
+
+#define wrap_set_taskbar_icon(plugin,image,icon) mock_set_taskbar_icon(image,icon)
+#define wrap_load_taskbar_pixbuf(plugin,image,icon) mock_load_taskbar_pixbuf(image,icon)
+
+#define CHECK_LONGPRESS
+
+/*----------------------------------------------------------------------------*/
+/* Global data                                                                */
+/*----------------------------------------------------------------------------*/
+
+extern const char *mock_icon;       /* Last icon set on the tray image, "frame" for animation frames */
+extern int mock_icon_size;
+extern int mock_icon_sets;          /* Number of times an icon or frame has been set - redraws */
+extern int mock_icon_loads;         /* Number of icons loaded at the taskbar size */
+
+/*----------------------------------------------------------------------------*/
+/* Prototypes                                                                 */
+/*----------------------------------------------------------------------------*/
+
+extern void mock_set_taskbar_icon (GtkWidget *image, const char *icon);
+extern GdkPixbuf *mock_load_taskbar_pixbuf (GtkWidget *image, const char *icon);
+extern void set_image_from_pixbuf (GtkWidget *image, GdkPixbuf *pixbuf);
+extern void show_menu_with_kbd (GtkWidget *widget, GtkWidget *menu);
+
+#endif /* end of include guard: MOCK_LXUTILS_H */
+
+/* End of file */
+/*----------------------------------------------------------------------------*/
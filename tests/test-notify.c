@@ -0,0 +1,218 @@
+/*============================================================================
+Copyright (c) 2025 Raspberry Pi
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the copyright holder nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+============================================================================*/
+
+/* Session-start notifications - alert latency and coalescing into one notification */
+
+#include "harness.h"
+
+/*----------------------------------------------------------------------------*/
+/* Typedefs and macros                                                        */
+/*----------------------------------------------------------------------------*/
+
+#define TIMEOUT 5000
+
+/*----------------------------------------------------------------------------*/
+/* Function definitions                                                       */
+/*----------------------------------------------------------------------------*/
+
+/* Conditions */
+
+static gboolean has_status (gpointer data)
+{
+    return ((ConnectPlugin *) data)->have_status;
+}
+
+static gboolean notify_idle (gpointer data)
+{
+    ConnectPlugin *c = (ConnectPlugin *) data;
+    return c->notify_id && !c->notify_busy;
+}
+
+static gboolean notify_sent (gpointer data)
+{
+    return ((ConnectPlugin *) data)->notify_busy;
+}
+
+static gboolean notified (gpointer data)
+{
+    return mock_notify.notify_count >= GPOINTER_TO_INT (data);
+}
+
+static gboolean closed (gpointer data)
+{
+    return mock_notify.close_count >= GPOINTER_TO_INT (data);
+}
+
+/* Helpers */
+
+static void set_sessions (int vnc, int ssh)
+{
+    mock_connect.vnc_sess_count = vnc;
+    mock_connect.ssh_sess_count = ssh;
+    harness_emit_status ();
+}
+
+static ConnectPlugin *start_plugin (void)
+{
+    ConnectPlugin *c;
+
+    harness_connect_up ();
+    c = harness_plugin_new ();
+    g_assert_true (harness_wait (has_status, c, TIMEOUT));
+    return c;
+}
+
+/* Tests */
+
+static void test_latency_and_coalesce (void)
+{
+    ConnectPlugin *c;
+    int budget = harness_budget ("CONNECT_NOTIFY_BUDGET_MS", 100);
+    gint64 sent;
+    guint32 id;
+    int latency;
+
+    harness_reset ();
+    c = start_plugin ();
+
+    // first session raises a new notification within the budget
+    sent = g_get_monotonic_time ();
+    set_sessions (1, 0);
+    g_assert_true (harness_wait (notified, GINT_TO_POINTER (1), TIMEOUT));
+    latency = (mock_notify.notify_time - sent) / 1000;
+    g_test_message ("Status to Notify latency %d ms, budget %d ms", latency, budget);
+    g_assert_cmpint (latency, <=, budget);
+    g_assert_cmpuint (mock_notify.last_replaces, ==, 0);
+    id = mock_notify.last_id;
+    g_assert_true (harness_wait (notify_idle, c, TIMEOUT));
+
+    // a further session replaces it
+    set_sessions (1, 1);
+    g_assert_true (harness_wait (notified, GINT_TO_POINTER (2), TIMEOUT));
+    g_assert_cmpuint (mock_notify.last_replaces, ==, id);
+    g_assert_true (harness_wait (notify_idle, c, TIMEOUT));
+
+    // changes arriving while a call is in flight collapse into a single follow-up
+    set_sessions (2, 1);
+    set_sessions (2, 2);
+    set_sessions (3, 2);
+    g_assert_true (harness_wait (notified, GINT_TO_POINTER (4), TIMEOUT));
+    g_assert_true (harness_wait (notify_idle, c, TIMEOUT));
+    harness_run (200);
+    g_assert_cmpint (mock_notify.notify_count, ==, 4);
+    g_assert_cmpuint (mock_notify.last_replaces, ==, id);
+
+    // the last session ending withdraws it
+    set_sessions (0, 0);
+    g_assert_true (harness_wait (closed, GINT_TO_POINTER (1), TIMEOUT));
+    g_assert_cmpuint (mock_notify.closed_id, ==, id);
+
+    harness_plugin_free (c);
+    harness_connect_down ();
+}
+
+static void test_existing_sessions (void)
+{
+    ConnectPlugin *c;
+
+    // sessions already running when the plugin starts are not announced
+    harness_reset ();
+    mock_connect.vnc_sess_count = 1;
+    c = start_plugin ();
+    harness_run (200);
+    g_assert_cmpint (mock_notify.notify_count, ==, 0);
+
+    harness_plugin_free (c);
+    harness_connect_down ();
+}
+
+static void test_service_exit (void)
+{
+    ConnectPlugin *c;
+
+    harness_reset ();
+    c = start_plugin ();
+    set_sessions (1, 0);
+    g_assert_true (harness_wait (notify_idle, c, TIMEOUT));
+
+    // the service leaving the bus withdraws the notification and clears the sessions
+    harness_connect_down ();
+    g_assert_true (harness_wait (closed, GINT_TO_POINTER (1), TIMEOUT));
+    g_assert_cmpuint (mock_notify.closed_id, ==, mock_notify.last_id);
+    g_assert_cmpint (c->vnc_sess_count + c->ssh_sess_count, ==, 0);
+
+    harness_plugin_free (c);
+}
+
+static void test_plugin_destroyed (void)
+{
+    ConnectPlugin *c;
+
+    harness_reset ();
+    c = start_plugin ();
+    set_sessions (1, 0);
+    g_assert_true (harness_wait (notify_idle, c, TIMEOUT));
+
+    // destroying the plugin withdraws its notification, as a new instance couldn't
+    harness_plugin_free (c);
+    g_assert_true (harness_wait (closed, GINT_TO_POINTER (1), TIMEOUT));
+    g_assert_cmpuint (mock_notify.closed_id, ==, mock_notify.last_id);
+
+    // destroying it with a call in flight must not call back into the freed plugin
+    mock_connect.vnc_sess_count = 0;
+    c = harness_plugin_new ();
+    g_assert_true (harness_wait (has_status, c, TIMEOUT));
+    set_sessions (1, 0);
+    g_assert_true (harness_wait (notify_sent, c, TIMEOUT));
+    harness_plugin_free (c);
+    harness_run (200);
+
+    harness_connect_down ();
+}
+
+/*----------------------------------------------------------------------------*/
+/* Main function                                                              */
+/*----------------------------------------------------------------------------*/
+
+int main (int argc, char *argv[])
+{
+    int res;
+
+    harness_init (&argc, &argv);
+
+    g_test_add_func ("/notify/latency-and-coalesce", test_latency_and_coalesce);
+    g_test_add_func ("/notify/existing-sessions", test_existing_sessions);
+    g_test_add_func ("/notify/service-exit", test_service_exit);
+    g_test_add_func ("/notify/plugin-destroyed", test_plugin_destroyed);
+
+    res = g_test_run ();
+    harness_cleanup ();
+    return res;
+}
+
+/* End of file */
+/*----------------------------------------------------------------------------*/
@@ -0,0 +1,177 @@
+/*============================================================================
+Copyright (c) 2025 Raspberry Pi
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the copyright holder nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+============================================================================*/
+
+/* Profiles - only the calls needed are issued, together, with one redraw once they have all completed */
+
+#include "harness.h"
+
+/*----------------------------------------------------------------------------*/
+/* Typedefs and macros                                                        */
+/*----------------------------------------------------------------------------*/
+
+#define TIMEOUT 5000
+
+/*----------------------------------------------------------------------------*/
+/* Function definitions                                                       */
+/*----------------------------------------------------------------------------*/
+
+/* Conditions */
+
+static gboolean has_status (gpointer data)
+{
+    return ((ConnectPlugin *) data)->have_status;
+}
+
+static gboolean redrawn (gpointer)
+{
+    return mock_icon_sets > 0;
+}
+
+/* Helpers */
+
+static ConnectPlugin *start_plugin (void)
+{
+    ConnectPlugin *c;
+
+    harness_connect_up ();
+    c = harness_plugin_new ();
+    g_assert_true (harness_wait (has_status, c, TIMEOUT));
+
+    // let startup settle, then count only what the profile causes
+    harness_run (200);
+    mock_icon_sets = 0;
+    return c;
+}
+
+/* Tests */
+
+static void test_one_change (void)
+{
+    ConnectPlugin *c;
+
+    harness_reset ();
+    mock_connect.ssh_on = TRUE;
+    c = start_plugin ();
+
+    // ssh is already on, so only screen sharing needs a call
+    g_assert_true (connect_control_msg (c, "profile vnc=on ssh=on"));
+    g_assert_cmpint (c->prof_calls, ==, 1);
+    g_assert_true (harness_wait (redrawn, NULL, TIMEOUT));
+    harness_run (200);
+
+    g_assert_cmpint (mock_connect.calls, ==, 1);
+    g_assert_cmpint (c->prof_calls, ==, 0);
+    g_assert_cmpint (mock_icon_sets, ==, 1);
+    g_assert_true (c->vnc_on);
+    g_assert_true (c->ssh_on);
+
+    harness_plugin_free (c);
+    harness_connect_down ();
+}
+
+static void test_two_changes (void)
+{
+    ConnectPlugin *c;
+
+    harness_reset ();
+    c = start_plugin ();
+
+    // both calls are in flight together, and the Status each one causes doesn't redraw
+    g_assert_true (connect_control_msg (c, "profile vnc=on ssh=on"));
+    g_assert_cmpint (c->prof_calls, ==, 2);
+    g_assert_true (harness_wait (redrawn, NULL, TIMEOUT));
+    harness_run (200);
+
+    g_assert_cmpint (mock_connect.calls, ==, 2);
+    g_assert_cmpint (c->prof_calls, ==, 0);
+    g_assert_cmpint (mock_icon_sets, ==, 1);
+    g_assert_true (c->vnc_on);
+    g_assert_true (c->ssh_on);
+
+    harness_plugin_free (c);
+    harness_connect_down ();
+}
+
+static void test_no_changes (void)
+{
+    ConnectPlugin *c;
+
+    harness_reset ();
+    mock_connect.vnc_on = TRUE;
+    mock_connect.ssh_on = TRUE;
+    c = start_plugin ();
+
+    // already in the requested state - nothing to call and nothing to redraw
+    g_assert_true (connect_control_msg (c, "profile vnc=on ssh=on"));
+    g_assert_cmpint (c->prof_calls, ==, 0);
+    harness_run (200);
+
+    g_assert_cmpint (mock_connect.calls, ==, 0);
+    g_assert_cmpint (mock_icon_sets, ==, 0);
+
+    harness_plugin_free (c);
+    harness_connect_down ();
+}
+
+static void test_plugin_destroyed (void)
+{
+    ConnectPlugin *c;
+
+    harness_reset ();
+    c = start_plugin ();
+
+    // destroying the plugin with calls in flight must not call back into it
+    g_assert_true (connect_control_msg (c, "profile vnc=on ssh=on"));
+    g_assert_cmpint (c->prof_calls, ==, 2);
+    harness_plugin_free (c);
+    harness_run (200);
+
+    harness_connect_down ();
+}
+
+/*----------------------------------------------------------------------------*/
+/* Main function                                                              */
+/*----------------------------------------------------------------------------*/
+
+int main (int argc, char *argv[])
+{
+    int res;
+
+    harness_init (&argc, &argv);
+
+    g_test_add_func ("/profile/one-change", test_one_change);
+    g_test_add_func ("/profile/two-changes", test_two_changes);
+    g_test_add_func ("/profile/no-changes", test_no_changes);
+    g_test_add_func ("/profile/plugin-destroyed", test_plugin_destroyed);
+
+    res = g_test_run ();
+    harness_cleanup ();
+    return res;
+}
+
+/* End of file */
+/*----------------------------------------------------------------------------*/
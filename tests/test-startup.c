@@ -0,0 +1,216 @@
+/*============================================================================
+Copyright (c) 2025 Raspberry Pi
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the copyright holder nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+============================================================================*/
+
+/* Startup budget - time and heap allocations from connect_init to the first correct icon */
+
+#include <stdlib.h>
+
+#include "harness.h"
+
+/*----------------------------------------------------------------------------*/
+/* Typedefs and macros                                                        */
+/*----------------------------------------------------------------------------*/
+
+#define TIMEOUT 10000
+
+/*----------------------------------------------------------------------------*/
+/* Global data                                                                */
+/*----------------------------------------------------------------------------*/
+
+static gint counting;
+static gint allocs;
+
+/*----------------------------------------------------------------------------*/
+/* Function definitions                                                       */
+/*----------------------------------------------------------------------------*/
+
+/* Allocation counting - wraps the glibc allocator for the whole process */
+
+extern void *__libc_malloc (size_t size);
+extern void *__libc_calloc (size_t nmemb, size_t size);
+extern void *__libc_realloc (void *ptr, size_t size);
+
+void *malloc (size_t size)
+{
+    if (g_atomic_int_get (&counting)) g_atomic_int_inc (&allocs);
+    return __libc_malloc (size);
+}
+
+void *calloc (size_t nmemb, size_t size)
+{
+    if (g_atomic_int_get (&counting)) g_atomic_int_inc (&allocs);
+    return __libc_calloc (nmemb, size);
+}
+
+void *realloc (void *ptr, size_t size)
+{
+    if (g_atomic_int_get (&counting)) g_atomic_int_inc (&allocs);
+    return __libc_realloc (ptr, size);
+}
+
+/* Conditions */
+
+static gboolean started (gpointer data)
+{
+    return ((ConnectPlugin *) data)->started;
+}
+
+/* Helpers */
+
+/* Start the plugin and check the first correct icon against the budgets - a NULL icon means hidden */
+static void check_startup (const char *label, const char *icon)
+{
+    ConnectPlugin *c;
+    int budget_ms = harness_budget ("CONNECT_STARTUP_BUDGET_MS", 1000);
+    int budget_allocs = harness_budget ("CONNECT_STARTUP_BUDGET_ALLOCS", 200000);
+    int elapsed, count;
+    gint64 start;
+
+    allocs = 0;
+    start = g_get_monotonic_time ();
+    g_atomic_int_set (&counting, 1);
+    c = harness_plugin_new ();
+    g_assert_true (harness_wait (started, c, TIMEOUT));
+    g_atomic_int_set (&counting, 0);
+    elapsed = (g_get_monotonic_time () - start) / 1000;
+    count = g_atomic_int_get (&allocs);
+
+    g_test_message ("%s: first correct icon after %d ms (plugin reports %d ms), %d allocations; budget %d ms, %d allocations",
+        label, elapsed, c->startup_ms, count, budget_ms, budget_allocs);
+
+    g_assert_cmpint (c->anim_count, ==, c->anim_frames);
+    if (icon)
+    {
+        g_assert_true (gtk_widget_get_visible (c->plugin));
+        g_assert_cmpstr (mock_icon, ==, icon);
+    }
+    else g_assert_false (gtk_widget_get_visible (c->plugin));
+
+    g_assert_cmpint (elapsed, <=, budget_ms);
+    g_assert_cmpint (count, <=, budget_allocs);
+
+    harness_plugin_free (c);
+}
+
+/* Tests */
+
+static void test_signed_in (void)
+{
+    harness_reset ();
+    harness_connect_up ();
+    check_startup ("signed in", "rpc-enabled");
+    harness_connect_down ();
+}
+
+static void test_active (void)
+{
+    harness_reset ();
+    mock_connect.vnc_sess_count = 1;
+    harness_connect_up ();
+    check_startup ("session active", "frame");
+    harness_connect_down ();
+}
+
+static void test_signed_out (void)
+{
+    harness_reset ();
+    mock_connect.signed_in = FALSE;
+    harness_connect_up ();
+    check_startup ("signed out", "rpc-disabled");
+    harness_connect_down ();
+}
+
+static void test_disabled (void)
+{
+    harness_reset ();
+    mock_connect.enabled = FALSE;
+    harness_connect_up ();
+    check_startup ("disabled", "rpc-disabled");
+    harness_connect_down ();
+}
+
+static void test_service_absent (void)
+{
+    harness_reset ();
+    check_startup ("service absent", "rpc-disabled");
+}
+
+static void test_not_installed (void)
+{
+    harness_reset ();
+    mock_connect.installed = FALSE;
+    check_startup ("not installed", NULL);
+}
+
+static void test_icon_cache (void)
+{
+    ConnectPlugin *c;
+
+    harness_reset ();
+    c = harness_plugin_new ();
+    g_assert_true (harness_wait (started, c, TIMEOUT));
+
+    // redrawing at the same icon size reuses the frames without loading anything
+    mock_icon_loads = 0;
+    connect_update_display (c);
+    g_assert_cmpint (mock_icon_loads, ==, 0);
+
+    // a new icon size regenerates them
+    mock_icon_size = c->icon_size = 32;
+    connect_update_display (c);
+    g_assert_cmpint (mock_icon_loads, ==, 1);
+    g_assert_cmpint (c->anim_count, ==, c->anim_frames);
+    g_assert_cmpint (gdk_pixbuf_get_width (c->anim[c->anim_count - 1]), ==, 32);
+
+    harness_plugin_free (c);
+}
+
+/*----------------------------------------------------------------------------*/
+/* Main function                                                              */
+/*----------------------------------------------------------------------------*/
+
+int main (int argc, char *argv[])
+{
+    int res;
+
+    harness_init (&argc, &argv);
+
+    g_test_add_func ("/startup/signed-in", test_signed_in);
+    g_test_add_func ("/startup/session-active", test_active);
+    g_test_add_func ("/startup/signed-out", test_signed_out);
+    g_test_add_func ("/startup/disabled", test_disabled);
+    g_test_add_func ("/startup/service-absent", test_service_absent);
+    g_test_add_func ("/startup/not-installed", test_not_installed);
+    g_test_add_func ("/startup/icon-cache", test_icon_cache);
+
+    res = g_test_run ();
+    harness_cleanup ();
+    return res;
+}
+
+/* End of file */
+/*----------------------------------------------------------------------------*/